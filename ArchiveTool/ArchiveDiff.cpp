@@ -0,0 +1,168 @@
+#include "ArchiveDiff.h"
+#include "gp2.h"
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+struct DiffSource {
+	FILE* f; // for comparing stored bytes; members are read through the archive itself
+	uint32_t length;
+	GP2File* archive;
+	std::vector<uint32_t> byHash;
+};
+
+// only the header and file tables get read here
+static bool OpenDiffSource(const char* fileName, DiffSource* source) {
+	source->archive = NULL;
+	source->f = fopen(fileName, "rb");
+	if (source->f == NULL) {
+		printf("Couldn't open %s!\n", fileName);
+		return false;
+	}
+	fseek(source->f, 0, SEEK_END);
+	source->length = ftell(source->f);
+
+	source->archive = GP2File::Open(fileName);
+	if (source->archive == NULL) {
+		printf("%s isn't a GP2 archive!\n", fileName);
+		return false;
+	}
+	GP2File* archive = source->archive;
+	for (uint32_t i = 0; i < archive->GetFileCount(); ++i) {
+		source->byHash.push_back(i);
+	}
+	std::sort(source->byHash.begin(), source->byHash.end(), [archive](uint32_t a, uint32_t b) {
+		return archive->GetFileHash(a) < archive->GetFileHash(b);
+	});
+	return true;
+}
+
+static void CloseDiffSource(DiffSource* source) {
+	delete source->archive;
+	if (source->f != NULL) {
+		fclose(source->f);
+	}
+}
+
+// false if the stored range runs off the end of the file
+static bool GetStoredRange(DiffSource* source, uint32_t index, uint32_t* offset, uint32_t* length) {
+	source->archive->GetStoredRange(index, offset, length);
+	return *offset <= source->length && *length <= source->length - *offset;
+}
+
+// compares in fixed size chunks so memory use doesn't depend on member size
+static bool StoredBytesEqual(DiffSource* oldSource, uint32_t oldIndex, DiffSource* newSource, uint32_t newIndex) {
+	uint32_t oldOffset;
+	uint32_t oldLength;
+	uint32_t newOffset;
+	uint32_t newLength;
+	if (!GetStoredRange(oldSource, oldIndex, &oldOffset, &oldLength) || !GetStoredRange(newSource, newIndex, &newOffset, &newLength) || oldLength != newLength) {
+		return false;
+	}
+	uint8_t oldChunk[0x4000];
+	uint8_t newChunk[0x4000];
+	fseek(oldSource->f, oldOffset, SEEK_SET);
+	fseek(newSource->f, newOffset, SEEK_SET);
+	while (oldLength != 0) {
+		uint32_t chunkLength = oldLength < sizeof(oldChunk) ? oldLength : sizeof(oldChunk);
+		if (fread(oldChunk, 1, chunkLength, oldSource->f) != chunkLength || fread(newChunk, 1, chunkLength, newSource->f) != chunkLength) {
+			return false;
+		}
+		if (memcmp(oldChunk, newChunk, chunkLength) != 0) {
+			return false;
+		}
+		oldLength -= chunkLength;
+	}
+	return true;
+}
+
+static bool MembersEqual(DiffSource* oldSource, uint32_t oldIndex, DiffSource* newSource, uint32_t newIndex, bool* reencoded) {
+	*reencoded = false;
+	uint32_t oldLength = oldSource->archive->GetFileLength(oldIndex);
+	if (oldLength != newSource->archive->GetFileLength(newIndex)) {
+		return false;
+	}
+	if (StoredBytesEqual(oldSource, oldIndex, newSource, newIndex)) {
+		return true;
+	}
+	if (!oldSource->archive->HasCompressedFiles() && !newSource->archive->HasCompressedFiles()) {
+		return false;
+	}
+	// different bytes on disk, but a different encoding of the same data is still the same file
+	uint8_t* oldData = oldSource->archive->ReadMember(oldIndex);
+	uint8_t* newData = newSource->archive->ReadMember(newIndex);
+	bool equal = oldData != NULL && newData != NULL && memcmp(oldData, newData, oldLength) == 0;
+	delete[] oldData;
+	delete[] newData;
+	*reencoded = equal;
+	return equal;
+}
+
+bool DiffArchives(const char* oldFileName, const char* newFileName) {
+	DiffSource oldSource;
+	DiffSource newSource;
+	if (!OpenDiffSource(oldFileName, &oldSource)) {
+		CloseDiffSource(&oldSource);
+		return false;
+	}
+	if (!OpenDiffSource(newFileName, &newSource)) {
+		CloseDiffSource(&oldSource);
+		CloseDiffSource(&newSource);
+		return false;
+	}
+
+	GP2File* oldArchive = oldSource.archive;
+	GP2File* newArchive = newSource.archive;
+	uint32_t added = 0;
+	uint32_t removed = 0;
+	uint32_t changed = 0;
+	uint32_t unchanged = 0;
+	uint32_t reencodedCount = 0;
+	// both sides are sorted by hash, so one pass over each pairs everything up
+	uint32_t i = 0;
+	uint32_t j = 0;
+	while (i < oldSource.byHash.size() || j < newSource.byHash.size()) {
+		uint32_t oldIndex = i < oldSource.byHash.size() ? oldSource.byHash[i] : 0;
+		uint32_t newIndex = j < newSource.byHash.size() ? newSource.byHash[j] : 0;
+		if (j >= newSource.byHash.size() || (i < oldSource.byHash.size() && oldArchive->GetFileHash(oldIndex) < newArchive->GetFileHash(newIndex))) {
+			printf("- %s (%u bytes)\n", oldArchive->GetFileName(oldIndex), oldArchive->GetFileLength(oldIndex));
+			++removed;
+			++i;
+		}
+		else if (i >= oldSource.byHash.size() || newArchive->GetFileHash(newIndex) < oldArchive->GetFileHash(oldIndex)) {
+			printf("+ %s (%u bytes)\n", newArchive->GetFileName(newIndex), newArchive->GetFileLength(newIndex));
+			++added;
+			++j;
+		}
+		else if (strcmp(oldArchive->GetFileName(oldIndex), newArchive->GetFileName(newIndex)) != 0) {
+			// same hash, different file
+			printf("- %s (%u bytes)\n", oldArchive->GetFileName(oldIndex), oldArchive->GetFileLength(oldIndex));
+			printf("+ %s (%u bytes)\n", newArchive->GetFileName(newIndex), newArchive->GetFileLength(newIndex));
+			++removed;
+			++added;
+			++i;
+			++j;
+		}
+		else {
+			bool reencoded;
+			if (MembersEqual(&oldSource, oldIndex, &newSource, newIndex, &reencoded)) {
+				++unchanged;
+				if (reencoded) {
+					++reencodedCount;
+				}
+			}
+			else {
+				printf("* %s (%u -> %u bytes)\n", newArchive->GetFileName(newIndex), oldArchive->GetFileLength(oldIndex), newArchive->GetFileLength(newIndex));
+				++changed;
+			}
+			++i;
+			++j;
+		}
+	}
+	printf("%u added, %u removed, %u changed, %u unchanged (%u stored differently)\n", added, removed, changed, unchanged, reencodedCount);
+
+	CloseDiffSource(&oldSource);
+	CloseDiffSource(&newSource);
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+#include <stdint.h>
+
+// Prints the entries added, removed and changed between two archives, matching members by name hash and name. Only the
+// file tables are read up front; stored bytes are compared first and members are only decoded when those differ but the
+// decoded sizes still agree.
+bool DiffArchives(const char* oldFileName, const char* newFileName);
\ No newline at end of file
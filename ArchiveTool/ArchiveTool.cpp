@@ -1,8 +1,31 @@
 #include "gp2.h"
-#include "CompressA.h"
+#include "RecursiveExtract.h"
+#include "ArchiveDiff.h"
+#include "ContentStore.h"
 #include <sys/stat.h>
+#include <stdlib.h>
 
+// 0: decompress, 1: compress, 2: recursive extract, 3: diff two archives, 4: deduplicated export
 #define EXEC_MODE 1
+// compress standalone files with the long match encoding (0x11 header); smaller, but it's not known whether the game
+// accepts it outside this tool, so it's off by default
+#define EXTENDED_MATCHES 0
+// compress the files inside gp2 archives; files that won't shrink are still stored as-is
+#define COMPRESS_ARCHIVE_FILES 0
+
+uint8_t* read_whole_file(const char* fileName, uint32_t* length) {
+    FILE* f = fopen(fileName, "rb");
+    if (f == NULL) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    *length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t* data = new uint8_t[*length];
+    fread(data, 1, *length, f);
+    fclose(f);
+    return data;
+}
 
 void decomp_mode(int argc, char** argv)
 {
@@ -10,30 +33,21 @@ void decomp_mode(int argc, char** argv)
         printf("Drag a file to decompress onto exe!");
         return;
     }
-    GP2File *file = GP2File::ReadFile(argv[1]);
+    GP2File *file = GP2File::Open(argv[1]);
     if (file == NULL) {
-        FileReader* f = new FileReader(argv[1]);
-        if (f->IsValid() == false) {
-            delete f;
+        uint32_t fileLen;
+        uint8_t* in = read_whole_file(argv[1], &fileLen);
+        if (in == NULL) {
             printf("Couldn't open file!");
             return;
         }
-        // try to detect if it uses the standard GP2 compression header
-        uint32_t header = f->ReadUInt32();
-        uint8_t* out;
         uint32_t decompFileSize;
-        if ((header & 0x7) == 0) {
-            // assume CompressA! this seems to be the default for things like monsters
-            decompFileSize = header >> 8;
-            out = DecompressA(f, decompFileSize, f->GetLength());
-        }
-        else {
-            f->Seek(0);
-            out = GP2File::DecompressSelection(f, f->GetLength());
-            f->Seek(0);
-            decompFileSize = f->ReadUInt32() >> 3;
+        uint8_t* out = GP2File::DecompressStandalone(in, fileLen, &decompFileSize);
+        delete[] in;
+        if (out == NULL) {
+            printf("Couldn't decompress file!");
+            return;
         }
-        delete f;
         char outputFileName[512];
         sprintf(outputFileName, "%s.dcmp", argv[1]);
         FILE* fi = fopen(outputFileName, "wb");
@@ -47,12 +61,25 @@ void decomp_mode(int argc, char** argv)
         delete[] out;
     }
     else {
+        // optional second argument caps the decoded data held in memory at once, in megabytes
+        uint64_t memoryLimit = 64;
+        if (argc > 2) {
+            memoryLimit = strtoull(argv[2], NULL, 10);
+            if (memoryLimit == 0 || memoryLimit > (UINT64_MAX >> 20)) {
+                printf("Memory limit has to be a number of megabytes!");
+                delete file;
+                return;
+            }
+        }
+        if (!file->ExportFiles("export", memoryLimit << 20)) {
+            printf("Couldn't export every file!");
+        }
         delete file;
     }
 }
 
 void comp_mode(int argc, char** argv) {
-    if (argc < 1) {
+    if (argc <= 1) {
         printf("Drag a folder or file onto the exe!");
         return;
     }
@@ -63,48 +90,91 @@ void comp_mode(int argc, char** argv) {
         return;
     }
     if (sb.st_mode & S_IFDIR) {
-        FILE* hashKey = fopen("hashkey.bin", "rb");
-        if (hashKey == NULL) {
+        FILE* hashKeyFile = fopen("hashkey.bin", "rb");
+        if (hashKeyFile == NULL) {
             printf("Hashkey file not found!");
             return;
         }
-        fread(GP2File::HashKey, sizeof(uint32_t) * 256, 1, hashKey);
-        fclose(hashKey);
-        GP2File* file = GP2File::CreateFromDirectory(argv[1]);
+        uint32_t hashKey[256];
+        fread(hashKey, sizeof(uint32_t) * 256, 1, hashKeyFile);
+        fclose(hashKeyFile);
+        GP2File* file = GP2File::CreateFromDirectory(argv[1], hashKey);
         char outFileName[512];
         sprintf(outFileName, "%s.gp2", argv[1]);
-        file->SaveArchive(outFileName);
+        GP2File::SaveStats stats;
+        if (!file->SaveArchive(outFileName, COMPRESS_ARCHIVE_FILES, &stats, 0)) {
+            printf("Failed to open output file!");
+        }
+        else if (COMPRESS_ARCHIVE_FILES) {
+            printf("%u compressed, %u stored raw after sampling, %u stored raw as compression didn't help; %llu -> %llu bytes\n",
+                stats.compressedFiles, stats.rawSampledFiles, stats.rawLargerFiles,
+                (unsigned long long)stats.inputBytes, (unsigned long long)stats.outputBytes);
+        }
+        delete file;
     }
     else {
-        FILE* f = fopen(argv[1], "rb");
-        fseek(f, 0, SEEK_END);
-        uint32_t fileLen = ftell(f);
-        fseek(f, 0, SEEK_SET);
-        uint8_t* uncompressedFile = new uint8_t[fileLen];
-        fread(uncompressedFile, fileLen, 1, f);
-        fclose(f);
+        uint32_t fileLen;
+        uint8_t* uncompressedFile = read_whole_file(argv[1], &fileLen);
+        if (uncompressedFile == NULL) {
+            printf("Couldn't open file!");
+            return;
+        }
         uint32_t compressedLen;
-        uint8_t *compressedFile = CompressA(uncompressedFile, fileLen, &compressedLen);
-
-        uint32_t compressedHeader = (fileLen << 8) | 0x10;
+        uint8_t *compressedFile = GP2File::CompressStandalone(uncompressedFile, fileLen, &compressedLen, EXTENDED_MATCHES, 0);
 
         delete[] uncompressedFile;
 
         char outFileName[512];
         sprintf(outFileName, "%s.cmp", argv[1]);
-        f = fopen(outFileName, "wb");
-        fwrite(&compressedHeader, 4, 1, f);
+        FILE* f = fopen(outFileName, "wb");
+        if (f == NULL) {
+            printf("Couldn't open output file!");
+            delete[] compressedFile;
+            return;
+        }
         fwrite(compressedFile, compressedLen, 1, f);
         fclose(f);
         delete[] compressedFile;
     }
 }
 
+void recursive_mode(int argc, char** argv) {
+    if (argc <= 1) {
+        printf("Drag files to extract onto exe!");
+        return;
+    }
+    for (int i = 1; i < argc; ++i) {
+        ExtractRecursive(argv[i], "export");
+    }
+}
+
+void diff_mode(int argc, char** argv) {
+    if (argc <= 2) {
+        printf("Drag an old and a new archive onto exe!");
+        return;
+    }
+    DiffArchives(argv[1], argv[2]);
+}
+
+void store_mode(int argc, char** argv) {
+    if (argc <= 1) {
+        printf("Drag archives to extract onto exe!");
+        return;
+    }
+    ExportToStore(argv + 1, argc - 1, "store", "export");
+}
+
 int main(int argc, char** argv) {
 #if EXEC_MODE == 0
     decomp_mode(argc, argv);
 #elif EXEC_MODE == 1
     comp_mode(argc, argv);
+#elif EXEC_MODE == 2
+    recursive_mode(argc, argv);
+#elif EXEC_MODE == 3
+    diff_mode(argc, argv);
+#elif EXEC_MODE == 4
+    store_mode(argc, argv);
 #endif
 
     return 0;
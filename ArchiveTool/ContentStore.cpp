@@ -0,0 +1,155 @@
+#include "ContentStore.h"
+#include "gp2.h"
+#include "Sha256.h"
+#include <atomic>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+struct StoreStats {
+	std::atomic<uint64_t> members;
+	std::atomic<uint64_t> memberBytes;
+	std::atomic<uint64_t> objectsWritten;
+	std::atomic<uint64_t> bytesWritten;
+	std::atomic<uint64_t> copies;
+	std::atomic<uint64_t> failures;
+	std::atomic<uint32_t> nextTempId;
+	uint64_t runId; // random per run, so runs sharing a store never write the same temporary file
+};
+
+enum ObjectResult {
+	OBJECT_WRITTEN,
+	OBJECT_EXISTED, // another task (or an earlier run) stored the same content first
+	OBJECT_FAILED
+};
+
+// written under a temporary name and then published with a create-if-absent hardlink, so an object path only ever holds
+// complete data and an object that exports already link to is never replaced when two tasks race on the same content
+static ObjectResult WriteObject(const fs::path& objectPath, const uint8_t* data, uint32_t length, uint64_t runId, uint32_t taskId) {
+	std::error_code error;
+	fs::create_directories(objectPath.parent_path(), error);
+	fs::path tempPath = objectPath;
+	char tempSuffix[48];
+	sprintf(tempSuffix, ".tmp%016llx-%u", (unsigned long long)runId, taskId);
+	tempPath += tempSuffix;
+	FILE* f = fopen(tempPath.generic_u8string().c_str(), "wb");
+	if (f == NULL) {
+		return OBJECT_FAILED;
+	}
+	bool written = fwrite(data, 1, length, f) == length;
+	fclose(f);
+	ObjectResult result = OBJECT_FAILED;
+	if (written) {
+		fs::create_hard_link(tempPath, objectPath, error);
+		if (!error) {
+			result = OBJECT_WRITTEN;
+		}
+		else if (fs::exists(objectPath)) {
+			result = OBJECT_EXISTED;
+		}
+		else {
+			// no hardlinks on this filesystem; copying still never overwrites an existing object
+			if (fs::copy_file(tempPath, objectPath, fs::copy_options::skip_existing, error)) {
+				result = OBJECT_WRITTEN;
+			}
+			else if (!error) {
+				result = OBJECT_EXISTED;
+			}
+		}
+	}
+	fs::remove(tempPath, error);
+	return result;
+}
+
+static void StoreMember(GP2File* archive, uint32_t index, const fs::path& storeDir, const fs::path& outputDir, StoreStats* stats) {
+	uint8_t* data = archive->ReadMember(index);
+	uint32_t length = archive->GetFileLength(index);
+	if (data == NULL) {
+		printf("Failed to extract %s\n", archive->GetFileName(index));
+		++stats->failures;
+		return;
+	}
+	// hashed straight after decoding while the data is still in cache
+	Sha256 hash;
+	hash.Update(data, length);
+	char hex[65];
+	hash.FinishHex(hex);
+	++stats->members;
+	stats->memberBytes += length;
+
+	fs::path objectPath = storeDir / "objects" / std::string(hex, 2) / (hex + 2);
+	std::error_code error;
+	if (!fs::exists(objectPath, error)) {
+		ObjectResult result = WriteObject(objectPath, data, length, stats->runId, stats->nextTempId++);
+		if (result == OBJECT_FAILED) {
+			printf("Couldn't write %s!\n", objectPath.generic_u8string().c_str());
+			++stats->failures;
+			delete[] data;
+			return;
+		}
+		if (result == OBJECT_WRITTEN) {
+			++stats->objectsWritten;
+			stats->bytesWritten += length;
+		}
+	}
+	delete[] data;
+
+	fs::path exportPath = outputDir / archive->GetFileName(index);
+	fs::remove(exportPath, error);
+	fs::create_hard_link(objectPath, exportPath, error);
+	if (error) {
+		fs::copy_file(objectPath, exportPath, fs::copy_options::overwrite_existing, error);
+		if (error) {
+			printf("Couldn't write %s!\n", exportPath.generic_u8string().c_str());
+			++stats->failures;
+			return;
+		}
+		++stats->copies;
+		stats->bytesWritten += length;
+	}
+}
+
+bool ExportToStore(const char* const* fileNames, uint32_t fileCount, const char* storeDir, const char* exportDir, uint32_t threadCount) {
+	StoreStats stats;
+	stats.members = 0;
+	stats.memberBytes = 0;
+	stats.objectsWritten = 0;
+	stats.bytesWritten = 0;
+	stats.copies = 0;
+	stats.failures = 0;
+	stats.nextTempId = 0;
+	std::random_device random;
+	stats.runId = (uint64_t)random() << 32 | random();
+
+	ThreadPool pool(threadCount);
+	GP2File** archives = new GP2File * [fileCount]();
+	for (uint32_t i = 0; i < fileCount; ++i) {
+		archives[i] = GP2File::Open(fileNames[i]);
+		if (archives[i] == NULL) {
+			printf("Couldn't open archive %s!\n", fileNames[i]);
+			++stats.failures;
+			continue;
+		}
+		fs::path outputDir = fs::path(exportDir) / fs::path(fileNames[i]).filename();
+		std::error_code error;
+		fs::create_directories(outputDir, error);
+		GP2File* archive = archives[i];
+		for (uint32_t j = 0; j < archive->GetFileCount(); ++j) {
+			pool.Submit([archive, j, storeDir, outputDir, &stats] { StoreMember(archive, j, storeDir, outputDir, &stats); });
+		}
+	}
+	pool.Wait();
+
+	for (uint32_t i = 0; i < fileCount; ++i) {
+		delete archives[i];
+	}
+	delete[] archives;
+
+	printf("%llu files (%llu bytes), %llu stored objects, %llu bytes written, %llu copied instead of linked\n",
+		(unsigned long long)stats.members.load(), (unsigned long long)stats.memberBytes.load(), (unsigned long long)stats.objectsWritten.load(),
+		(unsigned long long)stats.bytesWritten.load(), (unsigned long long)stats.copies.load());
+	return stats.failures == 0;
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+#include <stdint.h>
+
+// Exports the members of several archives into exportDir/<archive name>/, storing each distinct member only once as
+// storeDir/objects/<first two hex digits>/<sha-256> and hardlinking the export paths to it. Falls back to a copy where
+// the filesystem can't hardlink (e.g. export and store on different drives).
+bool ExportToStore(const char* const* fileNames, uint32_t fileCount, const char* storeDir, const char* exportDir, uint32_t threadCount = 0);
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "RecursiveExtract.h"
+#include "gp2.h"
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace fs = std::filesystem;
+
+static bool IsArchive(const uint8_t* data, uint32_t length) {
+	return length >= 16 && *(uint32_t*)data == 0x32435047;
+}
+
+static void WritePayload(const std::string& path, const uint8_t* data, uint32_t length) {
+	FILE* f = fopen(path.c_str(), "wb");
+	if (f == NULL) {
+		printf("Couldn't open output file %s!\n", path.c_str());
+		return;
+	}
+	fwrite(data, 1, length, f);
+	fclose(f);
+}
+
+static void ExtractPayload(ThreadPool* pool, uint8_t* data, uint32_t length, std::string path);
+
+// the last member task to finish frees the archive and the buffer it was opened from
+struct OpenedArchive {
+	GP2File* archive;
+	uint8_t* data;
+
+	~OpenedArchive() {
+		delete archive;
+		delete[] data;
+	}
+};
+
+static void ExtractMember(ThreadPool* pool, std::shared_ptr<OpenedArchive> opened, uint32_t index, std::string path) {
+	GP2File* archive = opened->archive;
+	uint32_t memberLength = archive->GetFileLength(index);
+	uint8_t* member = archive->ReadMember(index);
+	std::string memberPath = path + "/" + archive->GetFileName(index);
+	if (member == NULL) {
+		printf("Failed to extract %s\n", memberPath.c_str());
+		return;
+	}
+	ExtractPayload(pool, member, memberLength, memberPath);
+}
+
+// takes ownership of data
+static void ExtractPayload(ThreadPool* pool, uint8_t* data, uint32_t length, std::string path) {
+	if (IsArchive(data, length)) {
+		GP2File* archive = GP2File::OpenMemory(data, length);
+		if (archive != NULL) {
+			std::error_code error;
+			fs::create_directories(path, error);
+			// one task per member, so decoding a big archive is spread over the pool too
+			std::shared_ptr<OpenedArchive> opened(new OpenedArchive{ archive, data });
+			for (uint32_t i = 0; i < archive->GetFileCount(); ++i) {
+				pool->Submit([pool, opened, i, path] { ExtractMember(pool, opened, i, path); });
+			}
+			return;
+		}
+	}
+	WritePayload(path, data, length);
+	uint32_t decompressedLength;
+	uint8_t* decompressed = GP2File::ProbeStandalone(data, length, &decompressedLength);
+	if (decompressed != NULL) {
+		std::string decompressedPath = path + ".dcmp";
+		pool->Submit([pool, decompressed, decompressedLength, decompressedPath] { ExtractPayload(pool, decompressed, decompressedLength, decompressedPath); });
+	}
+	delete[] data;
+}
+
+bool ExtractRecursive(const char* fileName, const char* outputDir, uint32_t threadCount) {
+	FILE* f = fopen(fileName, "rb");
+	if (f == NULL) {
+		printf("Couldn't open file!");
+		return false;
+	}
+	fseek(f, 0, SEEK_END);
+	uint32_t length = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	uint8_t* data = new uint8_t[length];
+	fread(data, 1, length, f);
+	fclose(f);
+
+	std::error_code error;
+	fs::create_directories(outputDir, error);
+	std::string path = std::string(outputDir) + "/" + fs::path(fileName).filename().generic_u8string();
+
+	ThreadPool pool(threadCount);
+	pool.Submit([&pool, data, length, path] { ExtractPayload(&pool, data, length, path); });
+	pool.Wait();
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+#include <stdint.h>
+
+// Extracts a GP2 archive or standalone compressed file into outputDir/<file name>, descending into members that are
+// themselves archives (extracted into a folder named after the member) or carry the standalone compression header
+// (written alongside the raw member as <name>.dcmp). Everything is done in memory on a work-stealing pool.
+bool ExtractRecursive(const char* fileName, const char* outputDir, uint32_t threadCount = 0);
\ No newline at end of file
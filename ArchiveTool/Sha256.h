@@ -0,0 +1,19 @@
+#pragma once
+#include <stdint.h>
+
+class Sha256 {
+private:
+	uint32_t state[8];
+	uint8_t block[64];
+	uint32_t blockLength;
+	uint64_t totalLength;
+
+	void ProcessBlock(const uint8_t* data);
+public:
+	Sha256();
+
+	void Update(const uint8_t* data, uint32_t length);
+	void Finish(uint8_t digest[32]);
+	// 64 hex characters plus terminator
+	void FinishHex(char hex[65]);
+};
\ No newline at end of file
@@ -0,0 +1,328 @@
+#include "CompressA.h"
+#include "ThreadPool.h"
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+uint8_t* DecompressA(FileReader* f, uint32_t decompressedSize, uint32_t compressedEnd, uint8_t compressionType, uint8_t* output) {
+    uint8_t* dcmp = output;
+    if (dcmp == NULL) {
+        dcmp = new uint8_t[decompressedSize]();
+    }
+    else {
+        // a truncated stream leaves the rest zeroed, same as a fresh buffer
+        memset(dcmp, 0, decompressedSize);
+    }
+    uint32_t dcmpSize = 0;
+    uint32_t controlByte;
+    uint8_t controlByteBits = 0;
+    uint32_t copyBackControl = 0; // packed control character indicating how many to copy, how far back to copy, etc
+    uint32_t copyBackByteCount = 3; // how many bytes to read for the copy back control; 1-3
+    // compressionType: if set to 0, only 1 byte will ever be read for copy length/distance
+    // maybe set to 1 based on first 3 bits of flags value; either invert bit 0 as i see 1 set on my examples, or bit 1. bit 2 seems to indicate a completely different compression
+    // standalone files with a 0x11 header use 1
+    uint8_t* ret = dcmp;
+    for (;;) {
+        if (decompressedSize <= 0) {
+            break;
+        }
+        for (;;) {
+            if (controlByteBits == 0) {
+                break;
+            }
+            if (compressedEnd - f->GetPosition() <= 0) {
+                goto FINISH_DECOMPRESSA;
+            }
+            if ((controlByte & 0x80) == 0) {
+                *dcmp = f->ReadUInt8();
+                --decompressedSize;
+                ++dcmp;
+                ++dcmpSize;
+            }
+            else {
+                int32_t copyBackDistance;
+                for (;;) {
+                    if (copyBackByteCount == 0) {
+                        goto BREAKCOMPRESSATYPE1;
+                    }
+                    if (compressionType == 1) { // extended lengths; only seen with the 0x11 standalone header
+                        --copyBackByteCount;
+                        if (copyBackByteCount != 0) {
+                            if (copyBackByteCount != 1) {
+                                int extraToAdd; // this value is mildly confusing; wanting to copy 0x100 bytes is actually
+                                // pretty reasonable, but you can't with this system?
+                                copyBackControl = f->ReadUInt8();
+                                if (copyBackControl & 0xE0) { // upper 3 bits are set means only 1 byte; add 1 since you wouldn't compress a single byte
+                                    copyBackControl += 0x10;
+                                    copyBackByteCount = 0;
+                                    goto BYTE_READ_COMPRESSA;
+                                }
+                                else {
+                                    extraToAdd = 0x110;
+                                    if ((copyBackControl & 0x10) != 0) { // mark as 1 byte to copy back to indicate that it's actually encoded in 3 bytes, as 1 byte is unreasonable to compress
+                                        extraToAdd += 0x1000;
+                                        copyBackControl = extraToAdd + ((copyBackControl & 0xF) << 16);
+                                    }
+                                    else { // no bytes to copy back means it's encoded in 2 bytes
+                                        copyBackControl = extraToAdd + ((copyBackControl & 0xF) << 8);
+                                        copyBackByteCount = 1;
+                                    }
+                                }
+                            }
+                            else {
+                                copyBackControl += f->ReadUInt8() << 8;
+                            }
+                        }
+                        else {
+                            copyBackControl += f->ReadUInt8();
+                            goto BYTE_READ_COMPRESSA;
+                        }
+
+                    }
+                    else {
+                        break;
+                    }
+                    if (!(compressedEnd - f->GetPosition() <= 0)) {
+                        continue;
+                    }
+                    goto FINISH_DECOMPRESSA;
+                }
+                copyBackControl = 0x30 + f->ReadUInt8();
+                copyBackByteCount = 0;
+
+            BYTE_READ_COMPRESSA:
+                if (compressedEnd - f->GetPosition() <= 0) {
+                    goto FINISH_DECOMPRESSA;
+                }
+            BREAKCOMPRESSATYPE1:
+                copyBackDistance = 1 + (((copyBackControl & 0xF) << 8) | f->ReadUInt8());
+                copyBackByteCount = 3;
+
+
+                copyBackControl >>= 4;
+                if ((uint32_t)copyBackDistance > dcmpSize) {
+                    // corrupt stream; would copy from before the start of the buffer
+                    goto FINISH_DECOMPRESSA;
+                }
+                if (copyBackControl > decompressedSize) {
+                    copyBackControl = decompressedSize;
+                }
+                if (copyBackControl != 0) { // why isn't this just a while?
+                    do {
+                        *dcmp = dcmp[-copyBackDistance];
+                        --decompressedSize;
+                        ++dcmp;
+                        ++dcmpSize;
+                    } while (--copyBackControl > 0);
+                }
+            }
+            if (decompressedSize == 0) {
+                goto FINISH_DECOMPRESSA;
+            }
+            controlByte <<= 1;
+            --controlByteBits;
+        }
+        if (compressedEnd - f->GetPosition() <= 0) break;
+        controlByte = f->ReadUInt8();
+        controlByteBits = 8;
+    }
+FINISH_DECOMPRESSA:
+    return ret;
+}
+
+// longest match each mode can encode; extended lengths go up to 0xFFFF + 0x111 in the 4 byte form
+#define COMPRESSA_MAX_MATCH (0xF + 3)
+#define COMPRESSA_MAX_MATCH_EXTENDED (0xFFFF + 0x111)
+
+// a back-reference, or a single literal byte when length is 0
+struct CompressAToken {
+    uint32_t length;
+    uint32_t offs;
+};
+
+// finds tokens for input[start, end); matches may look up to 4095 bytes back past start, but never run past end
+static void FindTokensA(uint8_t* input, uint32_t start, uint32_t end, uint32_t maxMatch, std::vector<CompressAToken>& tokens) {
+    for (uint32_t i = start; i < end; ) {
+        uint32_t copyBackLength = 0;
+        uint32_t copyBackOffs = 0;
+        if (i >= 3) {
+            for (uint32_t j = 1; j < 4096 && j < i; ++j) {
+                uint32_t k = 0;
+                while (k < maxMatch && i + k < end && input[(i - j) + k] == input[i + k]) {
+                    ++k;
+                }
+                if (copyBackLength < k) {
+                    copyBackLength = k;
+                    copyBackOffs = j;
+                }
+                if (copyBackLength == maxMatch) {
+                    break;
+                }
+            }
+        }
+        CompressAToken token;
+        if (copyBackLength < 3) {
+            token.length = 0;
+            token.offs = 0;
+            ++i;
+        }
+        else {
+            token.length = copyBackLength;
+            token.offs = copyBackOffs;
+            i += copyBackLength;
+        }
+        tokens.push_back(token);
+    }
+}
+
+static uint8_t* EmitTokensA(uint8_t* input, std::vector<CompressAToken>& tokens, bool extended, uint32_t* outputLength) {
+    std::vector<uint8_t> compressed;
+    uint32_t controlByteTarget = 0;
+    uint8_t controlByte = 0;
+    uint8_t controlByteOffs = 0;
+    uint32_t inputPos = 0;
+    for (uint32_t i = 0; i < tokens.size(); ++i) {
+        if (controlByteOffs == 0) {
+            controlByteTarget = compressed.size();
+            compressed.push_back(0);
+        }
+        controlByte <<= 1;
+        if (tokens[i].length == 0) {
+            compressed.push_back(input[inputPos]);
+            ++inputPos;
+        }
+        else {
+            controlByte |= 0x1;
+            uint32_t copyBackOffs = tokens[i].offs - 1;
+            uint32_t length = tokens[i].length;
+            if (!extended) {
+                compressed.push_back((((length - 3) & 0xF) << 4) | (copyBackOffs >> 8));
+            }
+            else if (length <= 0x10) {
+                compressed.push_back(((length - 1) << 4) | (copyBackOffs >> 8));
+            }
+            else if (length <= 0x110) {
+                // top nibble 0 marks the 3 byte form
+                length -= 0x11;
+                compressed.push_back(length >> 4);
+                compressed.push_back(((length & 0xF) << 4) | (copyBackOffs >> 8));
+            }
+            else {
+                // top nibble 1 marks the 4 byte form
+                length -= 0x111;
+                compressed.push_back(0x10 | (length >> 12));
+                compressed.push_back((length >> 4) & 0xFF);
+                compressed.push_back(((length & 0xF) << 4) | (copyBackOffs >> 8));
+            }
+            compressed.push_back(copyBackOffs & 0xFF);
+            inputPos += tokens[i].length;
+        }
+        if (++controlByteOffs == 8) {
+            compressed[controlByteTarget] = controlByte;
+            controlByte = 0;
+            controlByteOffs = 0;
+        }
+    }
+    if (controlByteOffs != 0) {
+        compressed[controlByteTarget] = controlByte << (8 - controlByteOffs);
+    }
+    *outputLength = compressed.size();
+
+    uint8_t *ret = new uint8_t[compressed.size()];
+
+    memcpy(ret, compressed.data(), compressed.size());
+
+    return ret;
+}
+
+uint8_t* CompressA(uint8_t* input, uint32_t inputLength, uint32_t* outputLength, bool extended) {
+    std::vector<CompressAToken> tokens;
+    FindTokensA(input, 0, inputLength, extended ? COMPRESSA_MAX_MATCH_EXTENDED : COMPRESSA_MAX_MATCH, tokens);
+    return EmitTokensA(input, tokens, extended, outputLength);
+}
+
+uint8_t* CompressAParallel(uint8_t* input, uint32_t inputLength, uint32_t* outputLength, bool extended, uint32_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    // segments smaller than this aren't worth the matches lost at the seams
+    const uint32_t minSegmentLength = 0x10000;
+    uint32_t segmentLength = threadCount != 0 ? inputLength / threadCount + 1 : inputLength;
+    if (segmentLength < minSegmentLength) {
+        segmentLength = minSegmentLength;
+    }
+    uint32_t segmentCount = (inputLength + segmentLength - 1) / segmentLength;
+    if (segmentCount <= 1) {
+        // nothing to split, so don't pay for spinning up threads
+        return CompressA(input, inputLength, outputLength, extended);
+    }
+
+    ThreadPool pool(segmentCount < threadCount ? segmentCount : threadCount);
+    std::vector<std::vector<CompressAToken>> segmentTokens(segmentCount);
+    for (uint32_t i = 0; i < segmentCount; ++i) {
+        uint32_t start = i * segmentLength;
+        uint32_t end = start + segmentLength < inputLength ? start + segmentLength : inputLength;
+        std::vector<CompressAToken>* tokens = &segmentTokens[i];
+        uint32_t maxMatch = extended ? COMPRESSA_MAX_MATCH_EXTENDED : COMPRESSA_MAX_MATCH;
+        pool.Submit([input, start, end, maxMatch, tokens] { FindTokensA(input, start, end, maxMatch, *tokens); });
+    }
+    pool.Wait();
+
+    // segments end exactly on their boundary, so the token streams simply join up
+    std::vector<CompressAToken> tokens;
+    for (uint32_t i = 0; i < segmentCount; ++i) {
+        tokens.insert(tokens.end(), segmentTokens[i].begin(), segmentTokens[i].end());
+    }
+    return EmitTokensA(input, tokens, extended, outputLength);
+}
+
+float EstimateCompressARatio(const uint8_t* input, uint32_t inputLength) {
+    // sample a handful of windows the size of CompressA's search window
+    const uint32_t windowLength = 4096;
+    const uint32_t windowCount = 8;
+    uint32_t histogram[256] = { 0 };
+    uint32_t sampled = 0;
+    uint32_t repeated = 0;
+    uint16_t* lastSeen = new uint16_t[4096];
+    for (uint32_t w = 0; w < windowCount; ++w) {
+        uint32_t start = inputLength <= windowLength * windowCount ? w * windowLength : (uint32_t)(((uint64_t)(inputLength - windowLength) * w) / (windowCount - 1));
+        if (start >= inputLength) {
+            break;
+        }
+        uint32_t end = start + windowLength < inputLength ? start + windowLength : inputLength;
+        memset(lastSeen, 0xFF, sizeof(uint16_t) * 4096);
+        for (uint32_t i = start; i < end; ++i) {
+            ++histogram[input[i]];
+            ++sampled;
+            if (i + 2 >= end) {
+                continue;
+            }
+            // how often the next 3 bytes already appeared earlier in the window, i.e. could start a match
+            uint32_t trigramHash = ((input[i] << 16 | input[i + 1] << 8 | input[i + 2]) * 2654435761u) >> 20;
+            uint16_t previous = lastSeen[trigramHash];
+            if (previous != 0xFFFF && memcmp(&input[start + previous], &input[i], 3) == 0) {
+                ++repeated;
+            }
+            lastSeen[trigramHash] = i - start;
+        }
+    }
+    delete[] lastSeen;
+    if (sampled == 0) {
+        return 1.0f;
+    }
+
+    float entropy = 0.0f;
+    for (uint32_t i = 0; i < 256; ++i) {
+        if (histogram[i] != 0) {
+            float p = (float)histogram[i] / sampled;
+            entropy -= p * log2f(p);
+        }
+    }
+    float matched = (float)repeated / sampled;
+    // noise-like data; a flat histogram alone isn't enough, since ramps and repeated tiles are flat too
+    if (entropy > 7.9f && matched < 0.02f) {
+        return 1.125f;
+    }
+    // literals cost 9 bits, matched bytes roughly 17 bits per few bytes of match
+    return (1.0f - matched) * 1.125f + matched * 0.3f;
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+#include <stdint.h>
+#include "Reader.h"
+
+// compressionType 1 reads the extended match lengths; decodes into output when given (at least decompressedSize bytes),
+// otherwise into a new buffer
+uint8_t* DecompressA(FileReader* f, uint32_t decompressedSize, uint32_t compressedEnd, uint8_t compressionType = 0, uint8_t* output = NULL);
+
+// extended allows matches of up to 65808 bytes, which only decode with compressionType 1
+uint8_t* CompressA(uint8_t* input, uint32_t inputLength, uint32_t* outputLength, bool extended = false);
+
+// splits the input into one segment per thread and searches them concurrently; threadCount of 0 uses every hardware thread
+uint8_t* CompressAParallel(uint8_t* input, uint32_t inputLength, uint32_t* outputLength, bool extended = false, uint32_t threadCount = 0);
+
+// cheap guess at compressed size / input size from a few sampled windows, without running the match search
+float EstimateCompressARatio(const uint8_t* input, uint32_t inputLength);
\ No newline at end of file
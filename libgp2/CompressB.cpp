@@ -1,10 +1,10 @@
 #include "CompressB.h"
 #include <string.h>
 
-uint8_t* DecompressB(FileReader* input, uint32_t decompressedLength, uint32_t compressedEnd, const int32_t shiftAmount) {
+uint8_t* DecompressB(FileReader* input, uint32_t decompressedLength, uint32_t compressedEnd, const int32_t shiftAmount, uint8_t* output) {
 	uint32_t currDecomp = 0;
 
-	uint8_t* dcmp = new uint8_t[(decompressedLength + 3) & ~3]; // allocate data aligned to 4 bytes
+	uint8_t* dcmp = output != NULL ? output : new uint8_t[(decompressedLength + 3) & ~3]; // allocate data aligned to 4 bytes
 
 	uint32_t shiftRegister = 0;
 	uint32_t cumulative = 0;
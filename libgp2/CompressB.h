@@ -0,0 +1,6 @@
+#pragma once
+#include <stdint.h>
+#include "Reader.h"
+
+// output has to hold decompressedLength rounded up to 4 bytes when given; otherwise a new buffer is returned
+uint8_t* DecompressB(FileReader* input, uint32_t decompressedLength, uint32_t compressedEnd, const int32_t shiftAmount, uint8_t* output = NULL);
\ No newline at end of file
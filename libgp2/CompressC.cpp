@@ -0,0 +1,66 @@
+#include "CompressC.h"
+#include <string.h>
+#include <vector>
+
+uint8_t* DecompressC(FileReader* f, uint32_t decompressedSize, uint32_t compressedEnd, uint8_t* output) {
+	// simple RLE
+	uint8_t* dcmp = output != NULL ? output : new uint8_t[decompressedSize];
+	uint32_t dcmpPos = 0;
+
+	while (dcmpPos < decompressedSize && f->GetPosition() < (compressedEnd-1)) {
+		uint8_t controlChar = f->ReadUInt8();
+		if ((controlChar & 0x80) == 0) {
+			for (uint32_t i = 0; i <= (controlChar & 0x7F); ++i) {
+				dcmp[dcmpPos] = f->ReadUInt8();
+				++dcmpPos;
+			}
+		}
+		else {
+			uint32_t copyCount = controlChar & 0x7F;
+			copyCount += 2;
+			uint8_t toCopy = f->ReadUInt8();
+			for (uint32_t i = 0; i <= copyCount; ++i) {
+				dcmp[dcmpPos] = toCopy;
+				++dcmpPos;
+			}
+		}
+	}
+
+	return dcmp;
+}
+
+uint8_t* CompressC(const uint8_t* input, uint32_t inputLength, uint32_t* outputLength) {
+	std::vector<uint8_t> compressed;
+	uint32_t literalStart = 0;
+	uint32_t i = 0;
+	while (i < inputLength) {
+		// runs are 3 to 130 bytes long
+		uint32_t runLength = 1;
+		while (runLength < 0x7F + 3 && i + runLength < inputLength && input[i + runLength] == input[i]) {
+			++runLength;
+		}
+		if (runLength < 3) {
+			++i;
+			if (i - literalStart == 0x80 || i == inputLength) {
+				compressed.push_back((i - literalStart) - 1);
+				compressed.insert(compressed.end(), input + literalStart, input + i);
+				literalStart = i;
+			}
+			continue;
+		}
+		if (literalStart != i) {
+			compressed.push_back((i - literalStart) - 1);
+			compressed.insert(compressed.end(), input + literalStart, input + i);
+		}
+		compressed.push_back(0x80 | (runLength - 3));
+		compressed.push_back(input[i]);
+		i += runLength;
+		literalStart = i;
+	}
+	*outputLength = compressed.size();
+
+	uint8_t* ret = new uint8_t[compressed.size()];
+	memcpy(ret, compressed.data(), compressed.size());
+
+	return ret;
+}
\ No newline at end of file
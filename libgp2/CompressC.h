@@ -0,0 +1,8 @@
+#pragma once
+#include <stdint.h>
+#include "Reader.h"
+
+// decodes into output when given (at least decompressedSize bytes), otherwise into a new buffer
+uint8_t* DecompressC(FileReader* f, uint32_t decompressedSize, uint32_t compressedEnd, uint8_t* output = NULL);
+
+uint8_t* CompressC(const uint8_t* input, uint32_t inputLength, uint32_t* outputLength);
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "Reader.h"
+#include <string.h>
+
+FileReader::FileReader(const char* file) {
+	f = fopen(file, "rb");
+	buffer = NULL;
+	bufferLength = 0;
+	bufferPos = 0;
+}
+
+FileReader::FileReader(const uint8_t* data, uint32_t length) {
+	f = NULL;
+	buffer = data;
+	bufferLength = length;
+	bufferPos = 0;
+}
+
+FileReader::~FileReader() {
+	if (f == NULL) {
+		return;
+	}
+	fclose(f);
+}
+
+bool FileReader::IsValid() {
+	return f != NULL || buffer != NULL;
+}
+
+void FileReader::Read(void* out, uint32_t size) {
+	if (buffer == NULL) {
+		fread(out, size, 1, f);
+		return;
+	}
+	// reads past the end of a memory buffer come back as zeroes
+	uint32_t available = bufferPos < bufferLength ? bufferLength - bufferPos : 0;
+	if (size > available) {
+		memset((uint8_t*)out + available, 0, size - available);
+		size = available;
+	}
+	memcpy(out, buffer + bufferPos, size);
+	bufferPos += size;
+}
+
+uint32_t FileReader::GetLength() {
+	if (buffer != NULL) {
+		return bufferLength;
+	}
+	uint32_t currPos = ftell(f);
+	fseek(f, 0, SEEK_END);
+	uint32_t length = ftell(f);
+	fseek(f, currPos, SEEK_SET);
+	return length;
+}
+
+uint32_t FileReader::GetPosition() {
+	if (buffer != NULL) {
+		return bufferPos;
+	}
+	return ftell(f);
+}
+
+void FileReader::Seek(uint32_t position) {
+	if (buffer != NULL) {
+		bufferPos = position;
+		return;
+	}
+	fseek(f, position, SEEK_SET);
+}
+
+void FileReader::ReadBytes(uint8_t* out, uint32_t size) {
+	Read(out, size);
+}
+
+uint8_t FileReader::ReadUInt8() {
+	uint8_t ret;
+	Read(&ret, 1);
+	return ret;
+}
+
+uint16_t FileReader::ReadUInt16() {
+	uint16_t ret;
+	Read(&ret, 2);
+	return ret;
+}
+
+uint32_t FileReader::ReadUInt32() {
+	uint32_t ret;
+	Read(&ret, 4);
+	return ret;
+}
+
+int8_t FileReader::ReadInt8() {
+	int8_t ret;
+	Read(&ret, 1);
+	return ret;
+}
+
+int16_t FileReader::ReadInt16() {
+	int16_t ret;
+	Read(&ret, 2);
+	return ret;
+}
+
+int32_t FileReader::ReadInt32() {
+	int32_t ret;
+	Read(&ret, 4);
+	return ret;
+}
\ No newline at end of file
@@ -5,8 +5,15 @@
 class FileReader {
 private:
 	FILE *f;
+	// set when reading from memory instead of a file; not owned
+	const uint8_t* buffer;
+	uint32_t bufferLength;
+	uint32_t bufferPos;
+
+	void Read(void* out, uint32_t size);
 public:
 	FileReader(const char *file);
+	FileReader(const uint8_t* data, uint32_t length);
 	~FileReader();
 
 	bool IsValid();
@@ -15,6 +22,8 @@ public:
 	uint32_t GetPosition();
 	void Seek(uint32_t position);
 
+	// reads past the end come back as zeroes for memory buffers
+	void ReadBytes(uint8_t* out, uint32_t size);
 	uint8_t ReadUInt8();
 	uint16_t ReadUInt16();
 	uint32_t ReadUInt32();
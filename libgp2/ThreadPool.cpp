@@ -0,0 +1,118 @@
+#include "ThreadPool.h"
+
+// lets Submit find the calling worker's queue
+static thread_local ThreadPool* currentPool = NULL;
+static thread_local uint32_t currentQueue = 0;
+
+ThreadPool::ThreadPool(uint32_t threadCount) {
+	if (threadCount == 0) {
+		threadCount = std::thread::hardware_concurrency();
+		if (threadCount == 0) {
+			threadCount = 1;
+		}
+	}
+	queues = new WorkerQueue[threadCount];
+	queueCount = threadCount;
+	nextQueue = 0;
+	queuedTasks = 0;
+	pendingTasks = 0;
+	stopping = false;
+	for (uint32_t i = 0; i < threadCount; ++i) {
+		threads.push_back(std::thread(&ThreadPool::WorkerLoop, this, i));
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> guard(stateLock);
+		stopping = true;
+	}
+	workSignal.notify_all();
+	for (uint32_t i = 0; i < threads.size(); ++i) {
+		threads[i].join();
+	}
+	delete[] queues;
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+	uint32_t queue;
+	{
+		std::lock_guard<std::mutex> guard(stateLock);
+		++pendingTasks;
+		++queuedTasks; // counted before the push so a pop can never see it go negative
+		if (currentPool == this) {
+			queue = currentQueue;
+		}
+		else {
+			queue = nextQueue;
+			nextQueue = (nextQueue + 1) % queueCount;
+		}
+	}
+	{
+		std::lock_guard<std::mutex> guard(queues[queue].lock);
+		queues[queue].tasks.push_back(std::move(task));
+	}
+	workSignal.notify_one();
+}
+
+void ThreadPool::Wait() {
+	std::unique_lock<std::mutex> guard(stateLock);
+	doneSignal.wait(guard, [this] { return pendingTasks == 0; });
+}
+
+uint32_t ThreadPool::GetThreadCount() {
+	return queueCount;
+}
+
+bool ThreadPool::PopTask(uint32_t queue, std::function<void()>& task) {
+	// newest from our own queue keeps nested work hot in cache
+	{
+		std::lock_guard<std::mutex> guard(queues[queue].lock);
+		if (!queues[queue].tasks.empty()) {
+			task = std::move(queues[queue].tasks.back());
+			queues[queue].tasks.pop_back();
+			return true;
+		}
+	}
+	// otherwise steal the oldest task from someone else, which tends to be the biggest chunk of work
+	for (uint32_t i = 1; i < queueCount; ++i) {
+		WorkerQueue& victim = queues[(queue + i) % queueCount];
+		std::lock_guard<std::mutex> guard(victim.lock);
+		if (!victim.tasks.empty()) {
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void ThreadPool::WorkerLoop(uint32_t queue) {
+	currentPool = this;
+	currentQueue = queue;
+	for (;;) {
+		std::function<void()> task;
+		if (PopTask(queue, task)) {
+			{
+				std::lock_guard<std::mutex> guard(stateLock);
+				--queuedTasks;
+			}
+			task();
+			bool finished;
+			{
+				std::lock_guard<std::mutex> guard(stateLock);
+				--pendingTasks;
+				finished = pendingTasks == 0;
+			}
+			if (finished) {
+				doneSignal.notify_all();
+			}
+			continue;
+		}
+		std::unique_lock<std::mutex> guard(stateLock);
+		workSignal.wait(guard, [this] { return queuedTasks != 0 || stopping; });
+		if (stopping && queuedTasks == 0) {
+			return;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#include <stdint.h>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+// work-stealing pool; each worker pops its own newest task first and steals the oldest from the others when it runs dry
+class ThreadPool {
+private:
+	struct WorkerQueue {
+		std::mutex lock;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	std::vector<std::thread> threads;
+	WorkerQueue* queues;
+	uint32_t queueCount;
+	uint32_t nextQueue;
+
+	std::mutex stateLock;
+	std::condition_variable workSignal;
+	std::condition_variable doneSignal;
+	uint32_t queuedTasks; // tasks sitting in a queue
+	uint32_t pendingTasks; // tasks submitted but not finished yet
+	bool stopping;
+
+	bool PopTask(uint32_t queue, std::function<void()>& task);
+	void WorkerLoop(uint32_t queue);
+public:
+	// threadCount of 0 uses one worker per hardware thread
+	ThreadPool(uint32_t threadCount = 0);
+	~ThreadPool();
+
+	// safe to call from inside a running task; tasks submitted by a worker go on that worker's own queue
+	void Submit(std::function<void()> task);
+	// blocks until every submitted task, including ones they submit, has finished; don't call from a task
+	void Wait();
+
+	uint32_t GetThreadCount();
+};
\ No newline at end of file
@@ -0,0 +1,740 @@
+#include "gp2.h"
+#include "CompressB.h"
+#include "CompressA.h"
+#include "CompressC.h"
+#include "ThreadPool.h"
+#include <stdexcept>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// members whose sampled compression ratio comes out above this are stored raw without trying
+#define RAW_STORE_THRESHOLD 0.95f
+
+enum MemberDecision {
+	MEMBER_RAW,
+	MEMBER_COMPRESSED,
+	MEMBER_RAW_SAMPLED,
+	MEMBER_RAW_LARGER
+};
+
+struct FileEntry {
+	uint32_t hash;
+	uint32_t offs;
+	uint32_t size;
+};
+
+uint32_t GP2File::HashFileName(const char* fileName, const uint32_t* hashKey) {
+	uint32_t hash = 0xFFFFFFFF;
+	for (uint32_t i = 0; fileName[i] != 0; ++i) {
+		uint32_t tmp = fileName[i] ^ hash;
+		hash = (hash >> 8) ^ (hashKey[tmp & 0xFF]);
+	}
+	return ~hash;
+}
+
+uint8_t *GP2File::DecompressSelection(FileReader* f, uint32_t fileEnd, uint8_t* output, uint32_t outputLength) {
+	uint32_t compressionFlags = f->ReadUInt32();
+	uint32_t compressType = compressionFlags & 0x7; // yacker note: 5-7 are unknown
+	uint32_t decompressSize = compressionFlags >> 3;
+	// B writes whole words, so it needs the size rounded up
+	uint32_t neededLength = compressType == 2 || compressType == 3 ? (decompressSize + 3) & ~3 : decompressSize;
+	if (outputLength < neededLength) {
+		output = NULL;
+	}
+	uint8_t* retValue;
+	switch (compressType) {
+	case 0:
+		// uncompressed
+		retValue = output != NULL ? output : new uint8_t[decompressSize];
+		f->ReadBytes(retValue, decompressSize);
+		return retValue;
+		break;
+	case 1:
+		return DecompressA(f, decompressSize, fileEnd, 0, output);
+		break;
+	case 2:
+	case 3:
+		return DecompressB(f, decompressSize, fileEnd, 1 << compressType, output);
+		break;
+	case 4:
+		return DecompressC(f, decompressSize, fileEnd, output);
+		break;
+	default:
+		uint32_t debugHelper = f->GetPosition();
+		throw new std::exception("Unknown compression type!");
+		break;
+	}
+}
+
+uint8_t* GP2File::Compress(const uint8_t* input, uint32_t inputLength, CompressionType type, uint32_t* outputLength) {
+	uint8_t* compressed;
+	uint32_t compressedLength;
+	switch (type) {
+	case COMPRESSION_NONE:
+		compressedLength = inputLength;
+		compressed = new uint8_t[inputLength];
+		memcpy(compressed, input, inputLength);
+		break;
+	case COMPRESSION_A:
+		compressed = CompressA((uint8_t*)input, inputLength, &compressedLength);
+		break;
+	case COMPRESSION_C:
+		compressed = CompressC(input, inputLength, &compressedLength);
+		break;
+	default:
+		// no encoder for B yet
+		return NULL;
+	}
+	uint8_t* ret = new uint8_t[compressedLength + 4];
+	*(uint32_t*)ret = (inputLength << 3) | type;
+	memcpy(ret + 4, compressed, compressedLength);
+	delete[] compressed;
+	*outputLength = compressedLength + 4;
+	return ret;
+}
+
+uint8_t* GP2File::Decompress(const uint8_t* input, uint32_t inputLength, uint32_t* outputLength) {
+	if (inputLength < 4) {
+		return NULL;
+	}
+	FileReader f(input, inputLength);
+	try {
+		uint8_t* ret = DecompressSelection(&f, inputLength);
+		*outputLength = *(uint32_t*)input >> 3;
+		return ret;
+	}
+	catch (std::exception* e) {
+		delete e;
+		return NULL;
+	}
+}
+
+uint8_t* GP2File::CompressStandalone(const uint8_t* input, uint32_t inputLength, uint32_t* outputLength, bool extended, uint32_t threadCount) {
+	uint32_t compressedLength;
+	uint8_t* compressed = CompressAParallel((uint8_t*)input, inputLength, &compressedLength, extended, threadCount);
+	uint8_t* ret = new uint8_t[compressedLength + 4];
+	*(uint32_t*)ret = (inputLength << 8) | (extended ? 0x11 : 0x10);
+	memcpy(ret + 4, compressed, compressedLength);
+	delete[] compressed;
+	*outputLength = compressedLength + 4;
+	return ret;
+}
+
+// the stream has to end within the last few bytes of the input for it to count
+static uint8_t* DecompressStandaloneA(const uint8_t* input, uint32_t inputLength, uint8_t compressionType, uint32_t* outputLength) {
+	uint32_t size = *(uint32_t*)input >> 8;
+	FileReader f(input, inputLength);
+	f.Seek(4);
+	uint8_t* out = DecompressA(&f, size, inputLength, compressionType);
+	if (f.GetPosition() + 4 <= inputLength) {
+		delete[] out;
+		return NULL;
+	}
+	*outputLength = size;
+	return out;
+}
+
+uint8_t* GP2File::ProbeStandalone(const uint8_t* input, uint32_t inputLength, uint32_t* outputLength) {
+	if (inputLength < 8) {
+		return NULL;
+	}
+	uint32_t header = *(uint32_t*)input;
+	if ((header & 0xFF) != 0x10 && (header & 0xFF) != 0x11) {
+		return NULL;
+	}
+	uint32_t size = header >> 8;
+	// a match token can't expand 17 bits of input to more than 18 bytes, or 33 bits to 65808 with extended matches
+	uint32_t maxRatio = (header & 0xFF) == 0x10 ? 9 : 16000;
+	if (size == 0 || size / maxRatio > inputLength) {
+		return NULL;
+	}
+	return DecompressStandaloneA(input, inputLength, (header & 0xFF) == 0x11 ? 1 : 0, outputLength);
+}
+
+uint8_t* GP2File::DecompressStandalone(const uint8_t* input, uint32_t inputLength, uint32_t* outputLength) {
+	if (inputLength < 4) {
+		return NULL;
+	}
+	// try to detect if it uses the standard GP2 compression header
+	uint32_t header = *(uint32_t*)input;
+	if (header == 0x11 && inputLength == 4) {
+		// an empty file compressed with extended matches; a type 1 member of that size would need a stream after the header
+		return DecompressStandaloneA(input, inputLength, 1, outputLength);
+	}
+	if ((header & 0xFF) == 0x11 && (header >> 8) != 0 && (header >> 8) / 16000 <= inputLength) {
+		// CompressA with extended match lengths; a type 1 header can have the same low byte, so only take this
+		// when the stream ends with the input
+		uint8_t* out = DecompressStandaloneA(input, inputLength, 1, outputLength);
+		if (out != NULL) {
+			return out;
+		}
+	}
+	if ((header & 0x7) == 0) {
+		// assume CompressA! this seems to be the default for things like monsters
+		FileReader f(input, inputLength);
+		f.Seek(4);
+		*outputLength = header >> 8;
+		return DecompressA(&f, *outputLength, inputLength);
+	}
+	return Decompress(input, inputLength, outputLength);
+}
+
+GP2File::~GP2File() {
+	delete[] sourcePath;
+	if (files == NULL) {
+		return;
+	}
+	for (uint32_t i = 0; i < fileCount; ++i) {
+		if (files[i] == NULL) {
+			continue; // parsing stopped partway through
+		}
+		delete[] files[i]->name;
+		delete[] files[i]->data;
+		delete files[i];
+	}
+	delete[] files;
+}
+
+GP2File *GP2File::Open(const char *fileName) {
+	GP2File* gp2 = new GP2File();
+	gp2->sourcePath = new char[strlen(fileName) + 1];
+	strcpy(gp2->sourcePath, fileName);
+	FileReader* f = gp2->OpenSource();
+	if (f->IsValid() == false || !gp2->ParseFile(f)) {
+		delete f;
+		delete gp2;
+		return NULL;
+	}
+	delete f;
+	return gp2;
+}
+
+GP2File* GP2File::OpenMemory(const uint8_t* data, uint32_t length) {
+	GP2File* gp2 = new GP2File();
+	gp2->sourceData = data;
+	gp2->sourceLength = length;
+	FileReader* f = gp2->OpenSource();
+	if (!gp2->ParseFile(f)) {
+		delete f;
+		delete gp2;
+		return NULL;
+	}
+	delete f;
+	return gp2;
+}
+
+FileReader* GP2File::OpenSource() {
+	if (sourcePath != NULL) {
+		return new FileReader(sourcePath);
+	}
+	return new FileReader(sourceData, sourceLength);
+}
+
+int __cdecl fileEntrySorter(FileEntry* a, FileEntry* b) {
+	return (a->offs & 0xFFFFFF) - (b->offs & 0xFFFFFF);
+}
+
+int __cdecl fileEntryHashSorter(FileEntry* a, FileEntry* b) {
+	return a->hash > b->hash ? 1 : -1;
+}
+
+bool GP2File::ParseFile(FileReader* f) {
+	if (f->GetLength() < sizeof(GP2Header)) {
+		return false;
+	}
+	header.magic = f->ReadUInt32();
+	if (header.magic != 0x32435047) {
+		return false;
+	}
+	header.packedFileCount = f->ReadUInt16();
+	header.headerLength = f->ReadUInt16();
+	header.fileInfoLength = f->ReadUInt16();
+	header.firstFileOffs = f->ReadUInt16();
+	header.decompressedFileInfoLength = f->ReadUInt16();
+	header.decompressedFilenameLength = f->ReadUInt16(); // doesn't seem useful?
+	header.totalFileSize = f->ReadUInt32();
+
+	int32_t maxBinaryTreeIndices = 1 << ((header.packedFileCount & 0xF000) >> 12);
+	fileCount = header.packedFileCount & 0xFFF;
+	uint32_t firstFileOffs = header.firstFileOffs * 4;
+	uint8_t* fileInfoTree;
+	uint8_t* fileNames;
+	try {
+		f->Seek((header.headerLength << 2));
+		fileInfoTree = DecompressSelection(f, header.fileInfoLength * 4);
+	}
+	catch (std::exception* e) {
+		delete e;
+		fileCount = 0;
+		return false;
+	}
+	try {
+		f->Seek(header.fileInfoLength * 4);
+		fileNames = DecompressSelection(f, header.firstFileOffs * 4);
+	}
+	catch (std::exception* e) {
+		delete e;
+		delete[] fileInfoTree;
+		fileCount = 0;
+		return false;
+	}
+
+	// handled as a binary tree; start with the max indices, only bitshift right 1 if hash for file you want is < file hash stored, add the current value to a separate value also used in the check (ie fileInfo[bitshiftValue+separateValue]) and then bitshift right 1
+
+	struct FileEntry* entries = (FileEntry*)fileInfoTree;
+
+	qsort(entries, fileCount, sizeof(FileEntry), (_CoreCrtNonSecureSearchSortCompareFunction)fileEntrySorter);
+
+	char** fileNamesLinear = new char* [fileCount];
+	char* fileIters = (char*)fileNames;
+	for (uint32_t i = 0; i < fileCount; ++i) {
+		fileNamesLinear[i] = fileIters;
+		fileIters += strlen(fileIters) + 1;
+	}
+
+	compressedFiles = (header.totalFileSize & 0x10000000) == 0;
+
+	files = new GP2FileStorage * [fileCount]();
+	for (uint32_t i = 0; i < fileCount; ++i) {
+		files[i] = new GP2FileStorage();
+		files[i]->name = new char[strlen(fileNamesLinear[i]) + 1];
+		strcpy(files[i]->name, fileNamesLinear[i]);
+		files[i]->data = NULL;
+		files[i]->hash = entries[i].hash;
+		files[i]->offs = ((entries[i].offs & 0xFFFFFF) * 4) + firstFileOffs;
+		files[i]->storedLength = entries[i].size & 0xFFFFFF;
+		if (!compressedFiles) { // leaving here, but there doesn't seem to be a real indicator for file compression, you just gotta look :( (thankfully archives seem consistent about whether they use it or not for files)
+			files[i]->dataLength = files[i]->storedLength;
+		}
+		else {
+			f->Seek(files[i]->offs);
+			files[i]->dataLength = f->ReadUInt32() >> 3;
+		}
+	}
+
+	delete[] fileNames;
+	delete[] fileInfoTree;
+	delete[] fileNamesLinear;
+
+	return true;
+}
+
+uint32_t GP2File::GetFileCount() {
+	return fileCount;
+}
+
+bool GP2File::HasCompressedFiles() {
+	return compressedFiles;
+}
+
+const char* GP2File::GetFileName(uint32_t index) {
+	return files[index]->name;
+}
+
+uint32_t GP2File::GetFileLength(uint32_t index) {
+	return files[index]->dataLength;
+}
+
+int32_t GP2File::FindFile(const char* name) {
+	for (uint32_t i = 0; i < fileCount; ++i) {
+		if (strcmp(files[i]->name, name) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+uint32_t GP2File::GetFileHash(uint32_t index) {
+	return files[index]->hash;
+}
+
+void GP2File::GetStoredRange(uint32_t index, uint32_t* offset, uint32_t* length) {
+	*offset = files[index]->offs;
+	*length = files[index]->storedLength;
+}
+
+bool GP2File::ReadMember(uint32_t index, uint8_t* output, uint32_t outputLength) {
+	GP2FileStorage* file = files[index];
+	if (outputLength < file->dataLength) {
+		return false;
+	}
+	if (file->data != NULL) {
+		memcpy(output, file->data, file->dataLength);
+		return true;
+	}
+	FileReader* f = OpenSource();
+	if (f->IsValid() == false) {
+		delete f;
+		return false;
+	}
+	f->Seek(file->offs);
+	if (!compressedFiles) {
+		f->ReadBytes(output, file->dataLength);
+		delete f;
+		return true;
+	}
+	uint8_t* data;
+	try {
+		data = DecompressSelection(f, file->offs + file->storedLength, output, outputLength);
+	}
+	catch (std::exception* e) {
+		delete e;
+		delete f;
+		return false;
+	}
+	delete f;
+	// only when the decoder needed more room than the caller gave it
+	if (data != output) {
+		memcpy(output, data, file->dataLength);
+		delete[] data;
+	}
+	return true;
+}
+
+uint8_t* GP2File::ReadMember(uint32_t index) {
+	GP2FileStorage* file = files[index];
+	if (file->data == NULL && compressedFiles) {
+		// hand back the decoder's own buffer rather than copying it
+		FileReader* f = OpenSource();
+		if (f->IsValid() == false) {
+			delete f;
+			return NULL;
+		}
+		f->Seek(file->offs);
+		uint8_t* data;
+		try {
+			data = DecompressSelection(f, file->offs + file->storedLength);
+		}
+		catch (std::exception* e) {
+			delete e;
+			data = NULL;
+		}
+		delete f;
+		return data;
+	}
+	uint8_t* data = new uint8_t[file->dataLength];
+	if (!ReadMember(index, data, file->dataLength)) {
+		delete[] data;
+		return NULL;
+	}
+	return data;
+}
+
+static bool WriteMember(const char* dirName, const char* name, const uint8_t* data, uint32_t length) {
+	char fileNames[512];
+	sprintf(fileNames, "%s/%s", dirName, name);
+	FILE* f = fopen(fileNames, "wb");
+	if (f == NULL) {
+		return false;
+	}
+	fwrite(data, 1, length, f);
+	fclose(f);
+	return true;
+}
+
+bool GP2File::ExportFiles(const char* dirName, uint64_t memoryLimit, uint32_t threadCount) {
+	struct stat sb;
+
+	if (stat(dirName, &sb) != 0) {
+		fs::create_directory(dirName);
+	}
+
+	// members are already in on-disk order; they get decoded in parallel but written and freed strictly in that
+	// order, and nothing new is started while the decoded-but-unwritten members would go over memoryLimit
+	struct DecodedMember {
+		uint8_t* data;
+		bool done;
+	};
+	std::vector<DecodedMember> decoded(fileCount);
+	std::mutex decodedLock;
+	std::condition_variable decodedSignal;
+	uint64_t inFlight = 0;
+	uint32_t nextDecode = 0;
+	bool success = true;
+
+	ThreadPool pool(threadCount);
+	for (uint32_t i = 0; i < fileCount; ++i) {
+		// nextDecode == i means nothing is in flight, so a member bigger than the limit still gets through on its own
+		while (nextDecode < fileCount && (nextDecode == i || inFlight + files[nextDecode]->dataLength <= memoryLimit)) {
+			inFlight += files[nextDecode]->dataLength;
+			decoded[nextDecode].data = NULL;
+			decoded[nextDecode].done = false;
+			uint32_t index = nextDecode;
+			pool.Submit([this, index, &decoded, &decodedLock, &decodedSignal] {
+				uint8_t* data = ReadMember(index);
+				std::lock_guard<std::mutex> guard(decodedLock);
+				decoded[index].data = data;
+				decoded[index].done = true;
+				decodedSignal.notify_all();
+			});
+			++nextDecode;
+		}
+
+		uint8_t* data;
+		{
+			std::unique_lock<std::mutex> guard(decodedLock);
+			decodedSignal.wait(guard, [&decoded, i] { return decoded[i].done; });
+			data = decoded[i].data;
+		}
+		if (data == NULL || !WriteMember(dirName, files[i]->name, data, files[i]->dataLength)) {
+			success = false;
+		}
+		delete[] data;
+		inFlight -= files[i]->dataLength;
+	}
+	pool.Wait();
+	return success;
+}
+
+GP2File* GP2File::CreateFromDirectory(const char* dirName, const uint32_t* hashKey) {
+	std::vector<GP2Entry> entries;
+	std::vector<std::string> names;
+	for (const auto& entry : fs::directory_iterator(dirName)) {
+		names.push_back(entry.path().filename().generic_u8string());
+	}
+	for (uint32_t i = 0; i < names.size(); ++i) {
+		GP2Entry newFile;
+		newFile.name = names[i].c_str();
+
+		std::string dirStr = (fs::path(dirName) / names[i]).generic_u8string();
+
+		FILE* f = fopen(dirStr.c_str(), "rb");
+		if (f == NULL) {
+			continue;
+		}
+		fseek(f, 0, SEEK_END);
+		newFile.dataLength = ftell(f);
+		fseek(f, 0, SEEK_SET);
+		uint8_t* data = new uint8_t[newFile.dataLength];
+		fread(data, 1, newFile.dataLength, f);
+		fclose(f);
+		newFile.data = data;
+
+		entries.push_back(newFile);
+	}
+
+	GP2File* ret = Create(entries.data(), entries.size(), hashKey);
+
+	for (uint32_t i = 0; i < entries.size(); ++i) {
+		delete[] entries[i].data;
+	}
+
+	return ret;
+}
+
+GP2File* GP2File::Create(const GP2Entry* entries, uint32_t entryCount, const uint32_t* hashKey) {
+	GP2File* ret = new GP2File();
+	ret->fileCount = entryCount;
+	ret->files = new GP2FileStorage * [entryCount];
+	for (uint32_t i = 0; i < entryCount; ++i) {
+		GP2FileStorage* newFile = new GP2FileStorage();
+		newFile->name = new char[strlen(entries[i].name) + 1];
+		strcpy(newFile->name, entries[i].name);
+		newFile->data = new uint8_t[entries[i].dataLength];
+		memcpy(newFile->data, entries[i].data, entries[i].dataLength);
+		newFile->dataLength = entries[i].dataLength;
+		newFile->hash = HashFileName(newFile->name, hashKey);
+		newFile->offs = 0;
+		newFile->storedLength = newFile->dataLength;
+		ret->files[i] = newFile;
+	}
+	return ret;
+}
+
+bool GP2File::SaveArchive(const char* fileName, bool compressFiles, SaveStats* stats, uint32_t threadCount) {
+	// error out early if the file isn't available
+	FILE* f = fopen(fileName, "wb");
+	if (f == NULL) {
+		// well, that sucks
+		return false;
+	}
+
+	uint32_t length;
+	uint8_t* archive = SaveArchiveToMemory(&length, compressFiles, stats, threadCount);
+	if (archive == NULL) {
+		fclose(f);
+		return false;
+	}
+	fwrite(archive, 1, length, f);
+	fclose(f);
+	delete[] archive;
+	return true;
+}
+
+// returns the member as it gets written; may be the member's own data, so check before deleting
+uint8_t* GP2File::PrepareMember(uint32_t index, bool compress, uint32_t* storedLength, uint8_t* decision) {
+	// members of opened archives get read back from the source
+	uint8_t* data = files[index]->data != NULL ? files[index]->data : ReadMember(index);
+	uint32_t dataLength = files[index]->dataLength;
+	if (data == NULL || !compress) {
+		*storedLength = dataLength;
+		*decision = MEMBER_RAW;
+		return data;
+	}
+
+	uint8_t* compressed = NULL;
+	uint32_t compressedLength = 0;
+	if (EstimateCompressARatio(data, dataLength) > RAW_STORE_THRESHOLD) {
+		*decision = MEMBER_RAW_SAMPLED;
+	}
+	else {
+		compressed = CompressA(data, dataLength, &compressedLength);
+		*decision = MEMBER_COMPRESSED;
+		if (compressedLength >= dataLength) {
+			delete[] compressed;
+			compressed = NULL;
+			*decision = MEMBER_RAW_LARGER;
+		}
+	}
+
+	uint32_t type = compressed != NULL ? COMPRESSION_A : COMPRESSION_NONE;
+	uint32_t payloadLength = compressed != NULL ? compressedLength : dataLength;
+	uint8_t* stored = new uint8_t[payloadLength + 4];
+	*(uint32_t*)stored = (dataLength << 3) | type;
+	memcpy(stored + 4, compressed != NULL ? compressed : data, payloadLength);
+	*storedLength = payloadLength + 4;
+	delete[] compressed;
+	if (data != files[index]->data) {
+		delete[] data;
+	}
+	return stored;
+}
+
+uint8_t* GP2File::SaveArchiveToMemory(uint32_t* length, bool compressFiles, SaveStats* stats, uint32_t threadCount) {
+	std::vector<uint8_t*> storedData(fileCount);
+	std::vector<uint32_t> storedLengths(fileCount);
+	std::vector<uint8_t> decisions(fileCount);
+	if (compressFiles && threadCount != 1) {
+		ThreadPool pool(threadCount);
+		for (uint32_t i = 0; i < fileCount; ++i) {
+			pool.Submit([this, i, &storedData, &storedLengths, &decisions] {
+				storedData[i] = PrepareMember(i, true, &storedLengths[i], &decisions[i]);
+			});
+		}
+		pool.Wait();
+	}
+	else {
+		for (uint32_t i = 0; i < fileCount; ++i) {
+			storedData[i] = PrepareMember(i, compressFiles, &storedLengths[i], &decisions[i]);
+		}
+	}
+
+	if (stats != NULL) {
+		*stats = { 0 };
+	}
+	std::vector<uint8_t> fileData;
+	std::vector<uint32_t> fileOffsets;
+	bool failed = false;
+	for (uint32_t i = 0; i < fileCount; ++i) {
+		fileOffsets.push_back(fileData.size());
+		uint8_t* data = storedData[i];
+		if (data == NULL) {
+			failed = true;
+			continue;
+		}
+		fileData.insert(fileData.end(), data, data + storedLengths[i]);
+		if (data != files[i]->data) {
+			delete[] data;
+		}
+		while (fileData.size() % 16 != 0) {
+			fileData.push_back(0);
+		}
+		if (stats != NULL) {
+			stats->compressedFiles += decisions[i] == MEMBER_COMPRESSED;
+			stats->rawSampledFiles += decisions[i] == MEMBER_RAW_SAMPLED;
+			stats->rawLargerFiles += decisions[i] == MEMBER_RAW_LARGER;
+			stats->inputBytes += files[i]->dataLength;
+			stats->outputBytes += storedLengths[i];
+		}
+	}
+	if (failed) {
+		return NULL;
+	}
+
+	std::vector<FileEntry> fileEntries;
+	// hash the file names
+	for (uint32_t i = 0; i < fileCount; ++i) {
+		FileEntry newEntry;
+		newEntry.offs = ((fileOffsets[i] >> 2) & 0xFFFFFF) | ((i & 0xFF) << 24);
+		newEntry.size = ((storedLengths[i]) & 0xFFFFFF) | ((i & 0xFF00) << 16);
+		newEntry.hash = files[i]->hash;
+
+		fileEntries.push_back(newEntry);
+	}
+
+	qsort(&fileEntries[0], fileCount, sizeof(FileEntry), (_CoreCrtNonSecureSearchSortCompareFunction)fileEntryHashSorter);
+
+	uint32_t treeDepth = fileCount;
+	uint32_t treeShift = 0;
+	while (treeDepth != 0) {
+		treeDepth = fileCount >> treeShift;
+		++treeShift;
+	}
+	--treeShift;
+	// built locally so several threads can save the same archive at once
+	struct GP2Header archiveHeader = { 0 };
+	archiveHeader.packedFileCount = ((treeShift & 0xF) << 12) | (fileCount & 0xFFF);
+	archiveHeader.magic = 0x32435047;
+	archiveHeader.headerLength = 0x5;
+
+	// compress header info and file names
+	uint32_t fileInfoLength;
+	//uint8_t *fileInfo = CompressA((uint8_t*)&fileEntries[0], fileEntries.size() * sizeof(FileEntry), &fileInfoLength);
+	fileInfoLength = fileEntries.size() * sizeof(FileEntry);
+	uint8_t* fileInfo = new uint8_t[fileInfoLength];
+	memcpy(fileInfo, &fileEntries[0], fileInfoLength);
+
+	archiveHeader.fileInfoLength = ((fileInfoLength + 7) >> 2) + archiveHeader.headerLength;
+	
+	std::vector<char> flatNames;
+	for (uint32_t i = 0; i < fileCount; ++i) {
+		uint32_t j = 0;
+		do {
+			flatNames.push_back(files[i]->name[j]);
+		} while (files[i]->name[j++] != 0);
+	}
+
+	uint32_t fileNameLength;
+	uint8_t* fileNamesCompress = CompressA((uint8_t*)&flatNames[0], flatNames.size(), &fileNameLength);
+
+	archiveHeader.firstFileOffs = ((((fileNameLength + (archiveHeader.fileInfoLength << 2) + 19) / 16 ) * 16) >> 2);
+
+	archiveHeader.decompressedFileInfoLength = (fileEntries.size() * sizeof(FileEntry) + 3) >> 2;
+	archiveHeader.decompressedFilenameLength = (flatNames.size() + 3) >> 2;
+
+	archiveHeader.totalFileSize = ((fileData.size() + 3) >> 2) | (compressFiles ? 0 : 0x10000000);
+
+	// all the data *should* be good to write now
+	std::vector<uint8_t> out;
+	out.insert(out.end(), (uint8_t*)&archiveHeader, (uint8_t*)&archiveHeader + sizeof(archiveHeader));
+	
+	uint32_t compressedDataHeader = 0x0 | ((fileEntries.size() * sizeof(FileEntry)) << 3);
+	out.insert(out.end(), (uint8_t*)&compressedDataHeader, (uint8_t*)&compressedDataHeader + 4);
+	out.insert(out.end(), fileInfo, fileInfo + fileInfoLength);
+	while ((out.size() % 4) != 0) {
+		out.push_back(0);
+	}
+	
+	compressedDataHeader = 0x1 | ((flatNames.size()) << 3);
+	out.insert(out.end(), (uint8_t*)&compressedDataHeader, (uint8_t*)&compressedDataHeader + 4);
+	out.insert(out.end(), fileNamesCompress, fileNamesCompress + fileNameLength);
+	while ((out.size() % 16) != 0) {
+		out.push_back(0);
+	}
+	out.insert(out.end(), fileData.begin(), fileData.end());
+
+	delete[] fileNamesCompress;
+	delete[] fileInfo;
+
+	*length = out.size();
+	uint8_t* ret = new uint8_t[out.size()];
+	memcpy(ret, out.data(), out.size());
+	// winner
+	return ret;
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma once
+#include <stdint.h>
+#include "Reader.h"
+#include "ThreadPool.h" // part of the public API, for callers scheduling their own work alongside the library's
+
+// Everything here is safe to use from several threads at once as long as each GP2File is only modified by one of them;
+// reading members, listing entries and the codec functions don't touch any shared state.
+class GP2File {
+protected:
+	struct GP2Header
+	{
+		uint32_t magic;
+		uint16_t packedFileCount;
+		uint16_t headerLength;
+		uint16_t fileInfoLength;
+		uint16_t firstFileOffs;
+		uint16_t decompressedFileInfoLength;
+		uint16_t decompressedFilenameLength;
+		uint32_t totalFileSize;
+	};
+
+	struct GP2FileStorage {
+		char* name;
+		uint8_t* data; // only set for archives built in memory; opened archives read members on demand
+		uint32_t dataLength;
+		uint32_t hash;
+		uint32_t offs; // absolute offset of the stored member in the source
+		uint32_t storedLength;
+	};
+
+	GP2File() {
+		files = NULL;
+		fileCount = 0;
+		header = { 0 };
+		sourcePath = NULL;
+		sourceData = NULL;
+		sourceLength = 0;
+		compressedFiles = false;
+	}
+
+	struct GP2Header header;
+
+	GP2FileStorage** files;
+	uint32_t fileCount;
+
+	// where members of an opened archive are read from; every read opens its own reader so reads can run concurrently
+	char* sourcePath;
+	const uint8_t* sourceData;
+	uint32_t sourceLength;
+	bool compressedFiles;
+
+	FileReader* OpenSource();
+	bool ParseFile(FileReader* f);
+	uint8_t* PrepareMember(uint32_t index, bool compress, uint32_t* storedLength, uint8_t* decision);
+public:
+	enum CompressionType {
+		COMPRESSION_NONE = 0,
+		COMPRESSION_A = 1,
+		COMPRESSION_B4 = 2,
+		COMPRESSION_B8 = 3,
+		COMPRESSION_C = 4
+	};
+
+	struct GP2Entry {
+		const char* name;
+		const uint8_t* data;
+		uint32_t dataLength;
+	};
+
+	struct SaveStats {
+		uint32_t compressedFiles;
+		uint32_t rawSampledFiles; // sampling predicted too little gain, so the match search was skipped
+		uint32_t rawLargerFiles; // compressed, but came out no smaller than the original
+		uint64_t inputBytes;
+		uint64_t outputBytes; // members only, headers included
+	};
+
+	~GP2File();
+
+	// only the header and file tables are read up front
+	static GP2File *Open(const char *fileName);
+	// data isn't copied and has to outlive the returned archive
+	static GP2File *OpenMemory(const uint8_t* data, uint32_t length);
+	// entries are copied; hashKey is the 256 entry table from hashkey.bin
+	static GP2File *Create(const GP2Entry* entries, uint32_t entryCount, const uint32_t* hashKey);
+	static GP2File *CreateFromDirectory(const char* dirName, const uint32_t* hashKey);
+
+	// decodes into output when it has room for the member (returning output), otherwise into a new buffer
+	static uint8_t* DecompressSelection(FileReader* f, uint32_t fileEnd, uint8_t* output = NULL, uint32_t outputLength = 0);
+	static uint32_t HashFileName(const char* fileName, const uint32_t* hashKey);
+
+	// buffers as stored in archives, with the leading (size << 3 | type) word; returns NULL for types without an encoder
+	static uint8_t* Compress(const uint8_t* input, uint32_t inputLength, CompressionType type, uint32_t* outputLength);
+	static uint8_t* Decompress(const uint8_t* input, uint32_t inputLength, uint32_t* outputLength);
+	// standalone compressed files, as made by the compress tool; (size << 8 | 0x10) header, or 0x11 with extended matches
+	// threadCount of 0 uses every hardware thread
+	static uint8_t* CompressStandalone(const uint8_t* input, uint32_t inputLength, uint32_t* outputLength, bool extended = false, uint32_t threadCount = 1);
+	static uint8_t* DecompressStandalone(const uint8_t* input, uint32_t inputLength, uint32_t* outputLength);
+	// like DecompressStandalone, but only accepts the compress tool's own headers and a stream that ends where the input
+	// does, so it can be tried on arbitrary data; returns NULL when the data doesn't look compressed
+	static uint8_t* ProbeStandalone(const uint8_t* input, uint32_t inputLength, uint32_t* outputLength);
+
+	uint32_t GetFileCount();
+	// whether members of an opened archive carry their own compression header
+	bool HasCompressedFiles();
+	const char* GetFileName(uint32_t index);
+	uint32_t GetFileLength(uint32_t index);
+	// returns -1 if there's no such file
+	int32_t FindFile(const char* name);
+	uint32_t GetFileHash(uint32_t index);
+	// where the member sits in the source as stored, compression header included; only meaningful for opened archives
+	void GetStoredRange(uint32_t index, uint32_t* offset, uint32_t* length);
+
+	// output has to hold at least GetFileLength(index) bytes
+	bool ReadMember(uint32_t index, uint8_t* output, uint32_t outputLength);
+	// caller owns the returned data
+	uint8_t* ReadMember(uint32_t index);
+
+	// decodes members in parallel and writes them out in on-disk order, holding at most memoryLimit decoded bytes at once
+	// (or one member, if it's bigger than that); threadCount of 0 uses every hardware thread
+	bool ExportFiles(const char* dirName, uint64_t memoryLimit = 64ull << 20, uint32_t threadCount = 0);
+	// compressFiles stores members with CompressA where it pays off, compressing threadCount members at once (0 uses every
+	// hardware thread); stats can be NULL
+	bool SaveArchive(const char* fileName, bool compressFiles = false, SaveStats* stats = NULL, uint32_t threadCount = 1);
+	// caller owns the returned data
+	uint8_t* SaveArchiveToMemory(uint32_t* length, bool compressFiles = false, SaveStats* stats = NULL, uint32_t threadCount = 1);
+};
\ No newline at end of file